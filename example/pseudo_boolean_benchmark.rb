@@ -0,0 +1,57 @@
+require File.dirname(__FILE__) + '/example_helper'
+require 'benchmark'
+require 'rbconfig'
+
+# Compares the pseudo-Boolean propagator with MiniModel's linear expressions
+# (which end up in Gecode::linear) on the capacity constraint of a knapsack
+# with many items. Items are put in the knapsack greedily by branching on
+# one first. The number of items can be given as argument (default 10000).
+#
+# The first search includes posting the model. The model is then reset and
+# searched again, which only measures propagation and search (best of five).
+# Each variant runs in a process of its own (the script runs itself with
+# the name of the variant as second argument), since the bindings get
+# slower as the number of wrapped objects grows.
+class KnapsackCapacity
+  include Gecode::Mixin
+
+  def initialize(weights, capacity)
+    items_is_an bool_var_array(weights.size)
+
+    total_weight = (0...weights.size).inject(0) do |sum, i|
+      items[i] * weights[i] + sum
+    end
+    total_weight.must <= capacity
+
+    branch_on items, :value => :max
+  end
+end
+
+size = (ARGV[0] || 10000).to_i
+variants = [
+  ['MiniModel', nil],
+  ['pseudo-Boolean', Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD]]
+
+srand 42
+weights = Array.new(size){ rand(100) + 1 }
+capacity = weights.inject(0){ |sum, weight| sum + weight } / 4
+
+if ARGV[1].nil?
+  puts "#{size} items, capacity #{capacity}"
+  puts '                 first search    search again   propagations'
+  $stdout.flush
+  ruby = File.join(RbConfig::CONFIG['bindir'],
+    RbConfig::CONFIG['ruby_install_name'])
+  variants.each do |name, threshold|
+    system(ruby, __FILE__, size.to_s, name)
+  end
+else
+  name, threshold = variants.assoc(ARGV[1])
+  abort "Unknown variant: #{ARGV[1]}" if name.nil?
+  Gecode::Bool::Linear.pseudo_boolean_threshold = threshold
+  model = KnapsackCapacity.new(weights, capacity)
+  first = Benchmark.realtime{ model.solve! }
+  again = (1..5).map{ Benchmark.realtime{ model.reset!.solve! } }.min
+  puts '%-15s %12.2f s %12.3f s %14d' %
+    [name, first, again, model.search_stats[:propagations]]
+end
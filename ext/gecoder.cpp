@@ -20,23 +20,50 @@
 #include "gecoder.h"
 #include "gecode.hh"
 
+#include <algorithm>
 #include <iostream>
 #include <map>
+#include <sstream>
+#include <vector>
 
 namespace Gecode {
-  MSpace::MSpace() {
+  /*
+   * The values preferred by guided branchings, indexed by variable 
+   * identifier. The guide is shared by a space and all its clones.
+   */
+  struct MSpace::Guide {
+    int references;
+    std::vector<int> int_values;
+    std::vector<int> bool_values;
+
+    /*
+     * Looks up the value in the values, returns false if there is none.
+     */
+    static bool lookup(const std::vector<int>& values, int id, int& val) {
+      if (id < 0 || id >= static_cast<int>(values.size()))
+        return false;
+      val = values[id];
+      return val >= Int::Limits::min && val <= Int::Limits::max;
+    }
+  };
+
+  MSpace::MSpace() : guide(0) {
   }
 
-  MSpace::MSpace(bool share, MSpace& s) : Gecode::Space(share, s) {
+  MSpace::MSpace(bool share, MSpace& s) : Gecode::Space(share, s), 
+      guide(s.guide) {
     int_variables.update(this, share, s.int_variables);
     bool_variables.update(this, share, s.bool_variables);
     set_variables.update(this, share, s.set_variables);
+    if (guide != 0)
+      guide->references++;
   }
 
   MSpace::~MSpace() {
 #ifdef DEBUG
     fprintf(stderr, "gecoder: destructing MSpace %p\n", this);
 #endif
+    set_guide(IntArgs(0), IntArgs(0));
   }
 
   Gecode::Space* MSpace::copy(bool share) {
@@ -102,6 +129,141 @@ namespace Gecode {
     return &set_variables[id];
   }
 
+  /*
+   * Returns the number of integer variables in the space.
+   */
+  int MSpace::int_var_count() {
+    return int_variables.size();
+  }
+
+  /*
+   * Returns the number of boolean variables in the space.
+   */
+  int MSpace::bool_var_count() {
+    return bool_variables.size();
+  }
+
+  /*
+   * Returns the number of set variables in the space.
+   */
+  int MSpace::set_var_count() {
+    return set_variables.size();
+  }
+
+  /*
+   * Writes a reflection argument to the stream in a form that only depends
+   * on the argument's contents.
+   */
+  static void write_arg(std::ostream& os, const Reflection::Arg* arg) {
+    if (arg == 0) {
+      os << "n";
+    } else if (arg->isInt()) {
+      os << "i" << arg->toInt() << ";";
+    } else if (arg->isVar()) {
+      os << "v" << arg->toVar() << ";";
+    } else if (arg->isArray()) {
+      const Reflection::ArrayArg* a = arg->toArray();
+      os << "a" << a->size() << "[";
+      for (int i = 0; i < a->size(); i++) write_arg(os, (*a)[i]);
+      os << "]";
+    } else if (arg->isIntArray()) {
+      const Reflection::IntArrayArg* a = arg->toIntArray();
+      os << "I" << a->size() << "[";
+      for (int i = 0; i < a->size(); i++) os << (*a)[i] << ";";
+      os << "]";
+    } else if (arg->isString()) {
+      std::string str(arg->toString());
+      os << "s" << str.size() << ":" << str;
+    } else if (arg->isPair()) {
+      os << "p(";
+      write_arg(os, arg->first());
+      write_arg(os, arg->second());
+      os << ")";
+    } else if (arg->isSharedObject()) {
+      os << "o(";
+      write_arg(os, arg->toSharedObject());
+      os << ")";
+    } else if (arg->isSharedReference()) {
+      os << "r" << arg->toSharedReference() << ";";
+    }
+  }
+
+  /*
+   * Computes a canonical description of the space: the propagators and 
+   * branchings with their arguments followed by the domains of all 
+   * variables. Variables are numbered in the order that they were created, 
+   * so two spaces built by the same sequence of calls get the same 
+   * fingerprint. The space should be stable (i.e. status should have been 
+   * called). An empty string is returned if some actor does not support 
+   * reflection.
+   */
+  std::string MSpace::fingerprint() {
+    std::ostringstream os;
+    try {
+      Reflection::VarMap vm;
+      vm.putArray(this, int_variables, "i");
+      vm.putArray(this, bool_variables, "b");
+      vm.putArray(this, set_variables, "s");
+      
+      for (Reflection::ActorSpecIter it(this, vm); it(); ++it) {
+        Reflection::ActorSpec spec = it.actor();
+        os << (spec.isBranching() ? "B" : "P") << spec.ati().toString() 
+          << "(";
+        for (int i = 0; i < spec.noOfArgs(); i++) write_arg(os, spec[i]);
+        os << ")";
+      }
+
+      // Variables introduced by the actors were added to the map while 
+      // iterating, so the domains are written last.
+      for (Reflection::VarMapIter it(vm); it(); ++it) {
+        os << "V" << it.spec().vti().toString() << "(";
+        write_arg(os, it.spec().dom());
+        os << ")";
+      }
+    } catch (Gecode::Exception& e) {
+      return "";
+    }
+    return os.str();
+  }
+
+  /*
+   * Sets the values that guided branchings should try first, indexed by
+   * variable identifier. Values outside the integer limits mean that the
+   * variable has no preferred value. Spaces cloned before the call keep
+   * their guide, spaces cloned after get the new one.
+   */
+  void MSpace::set_guide(const IntArgs& int_values,
+      const IntArgs& bool_values) {
+    if (guide != 0 && --guide->references == 0)
+      delete guide;
+    guide = 0;
+    if (int_values.size() == 0 && bool_values.size() == 0)
+      return;
+
+    guide = new Guide();
+    guide->references = 1;
+    for (int i = 0; i < int_values.size(); i++)
+      guide->int_values.push_back(int_values[i]);
+    for (int i = 0; i < bool_values.size(); i++)
+      guide->bool_values.push_back(bool_values[i]);
+  }
+
+  /*
+   * Looks up the guided value of the integer variable with the specified
+   * identifier. Returns false if it has none.
+   */
+  bool MSpace::guided_int_val(int id, int& val) const {
+    return guide != 0 && Guide::lookup(guide->int_values, id, val);
+  }
+
+  /*
+   * Looks up the guided value of the boolean variable with the specified
+   * identifier. Returns false if it has none.
+   */
+  bool MSpace::guided_bool_val(int id, int& val) const {
+    return guide != 0 && Guide::lookup(guide->bool_values, id, val);
+  }
+
   void MSpace::gc_mark() {
     for(int i = 0; i < int_variables.size(); i++) {
       rb_gc_mark(Rust_gecode::cxx2ruby(&int_variables[i], false, false));
@@ -174,4 +336,245 @@ namespace Gecode {
       return d->fs->stop(s) || d->ts->stop(s) || d->ms->stop(s);
     }
   }
+
+  /*
+   * Stops the search of a single neighbourhood when either the neighbourhood's
+   * own fail limit or the stop object of the whole LNS search is hit.
+   */
+  class LNSStop : public Gecode::Search::Stop {
+    public:
+      LNSStop(int fails, Gecode::Search::Stop* outer) 
+        : fs(fails, -1, -1), outer(outer) {
+      }
+
+      bool stop(const Gecode::Search::Statistics &s) {
+        return fs.stop(s) || (outer != 0 && outer->stop(s));
+      }
+
+    private:
+      Search::MStop fs;
+      Gecode::Search::Stop* outer;
+  };
+
+  /* 
+   * MLNS performs Large Neighbourhood Search. The first solution is found 
+   * using plain DFS. After that every iteration clones the base space, 
+   * constrains it to be better than the best solution so far (using the same 
+   * constrain method as MBAB), fixes the decision variables outside of a 
+   * neighbourhood to their values in the best solution and runs a DFS with 
+   * a fail limit on the remaining ones. 
+   *
+   * The decision variables are the integer and boolean variables with the 
+   * given identifiers (those branched on, except the objective). Other 
+   * variables, such as the objective and auxiliary variables, are never 
+   * fixed since they depend on the decision variables and fixing them 
+   * would typically make the neighbourhood infeasible. Set variables are 
+   * never fixed either.
+   *
+   * The relaxation is given in percent of the decision variables that are
+   * unassigned in the base space. One more variable is relaxed every time
+   * as many neighbourhoods in a row have been searched completely without
+   * finding a better solution, so that the search does not get stuck in a 
+   * local optimum. The seed makes the search reproducible.
+   */
+  struct MLNS::Private {
+    MSpace* base;
+    MSpace* best;
+    Search::Options o;
+    LNSNeighbourhood neighbourhood;
+    int relaxation;
+    int fails;
+    int iterations;
+    unsigned int seed;
+    bool stopped;
+    Gecode::Search::Statistics stats;
+
+    // Identifiers of the decision variables that can be fixed.
+    std::vector<int> int_ids;
+    std::vector<int> bool_ids;
+
+    // The number of decision variables to relax and the number of 
+    // neighbourhoods of that size searched completely in a row.
+    unsigned int relaxed_count;
+    unsigned int exhausted_count;
+
+    // A linear congruential generator, so that the sequence of neighbourhoods
+    // only depends on the seed.
+    unsigned int random(unsigned int n) {
+      seed = seed * 1664525 + 1013904223;
+      return (seed >> 8) % n;
+    }
+
+    /*
+     * Deletes a space that might have been wrapped when passed to the 
+     * constrain method. The Ruby object is detached first, so that it 
+     * neither marks nor refers to the deleted space.
+     */
+    static void dispose(MSpace* space) {
+      if (space == 0) return;
+      VALUE rval = Rust_gecode::cxx2ruby(space, false, false);
+      if (!NIL_P(rval)) {
+        Rust_gecode::Gecode_MSpaceMap.erase(rval);
+        DATA_PTR(rval) = 0;
+      }
+      delete space;
+    }
+
+    void add_statistics(const Gecode::Search::Statistics &s) {
+      stats.propagate += s.propagate;
+      stats.fail += s.fail;
+      stats.clone += s.clone;
+      stats.commit += s.commit;
+      if (s.memory > stats.memory) stats.memory = s.memory;
+    }
+  };
+
+  MLNS::MLNS(MSpace* space, const Search::Options &o, 
+      const IntArgs& int_ids, const IntArgs& bool_ids,
+      LNSNeighbourhood neighbourhood, int relaxation, int fails, 
+      int iterations, int seed) : d(new Private) {
+    d->best = 0;
+    d->o = o;
+    d->neighbourhood = neighbourhood;
+    d->relaxation = relaxation;
+    d->fails = fails;
+    d->iterations = iterations;
+    d->seed = seed;
+    d->stopped = false;
+
+    if (space->status(d->stats.propagate) == SS_FAILED) {
+      d->base = 0;
+      d->stats.fail++;
+      return;
+    }
+    d->base = static_cast<MSpace*>(space->clone());
+    for (int i = 0; i < int_ids.size(); i++) {
+      int id = int_ids[i];
+      if (id >= 0 && id < d->base->int_var_count() && 
+          !d->base->int_var(id)->assigned()) {
+        d->int_ids.push_back(id);
+      }
+    }
+    for (int i = 0; i < bool_ids.size(); i++) {
+      int id = bool_ids[i];
+      if (id >= 0 && id < d->base->bool_var_count() && 
+          !d->base->bool_var(id)->assigned()) {
+        d->bool_ids.push_back(id);
+      }
+    }
+
+    unsigned int count = d->int_ids.size() + d->bool_ids.size();
+    d->relaxed_count = (count * relaxation + 99) / 100;
+    if (d->relaxed_count > count) d->relaxed_count = count;
+    d->exhausted_count = 0;
+  }
+
+  MLNS::~MLNS() {
+    delete d->base;
+    Private::dispose(d->best);
+    delete d;
+  }
+
+  /*
+   * Returns the next improving solution, or NULL if none could be found 
+   * within the iteration limit or the search was stopped.
+   */
+  MSpace* MLNS::next() {
+    if (d->base == 0) return 0;
+
+    if (d->best == 0) {
+      Gecode::DFS<MSpace> e(d->base, d->o);
+      d->best = e.next();
+      d->add_statistics(e.statistics());
+      d->stopped = e.stopped();
+      if (d->best == 0) return 0;
+      return static_cast<MSpace*>(d->best->clone());
+    }
+
+    unsigned int int_count = d->int_ids.size();
+    unsigned int count = int_count + d->bool_ids.size();
+
+    LNSStop stop(d->fails, d->o.stop);
+    Search::Options o = d->o;
+    o.stop = &stop;
+
+    std::vector<bool> relaxed(count);
+    while (d->iterations-- > 0) {
+      if (d->o.stop != 0 && d->o.stop->stop(d->stats)) {
+        d->stopped = true;
+        return 0;
+      }
+
+      // Pick the neighbourhood.
+      relaxed.assign(count, false);
+      if (d->neighbourhood == LNS_BLOCK) {
+        unsigned int start = count > 0 ? d->random(count) : 0;
+        for (unsigned int i = 0; i < d->relaxed_count; i++) {
+          relaxed[(start + i) % count] = true;
+        }
+      } else {
+        // Sample without replacement by selecting among the not yet relaxed.
+        std::vector<unsigned int> candidates(count);
+        for (unsigned int i = 0; i < count; i++) candidates[i] = i;
+        for (unsigned int i = 0; i < d->relaxed_count; i++) {
+          unsigned int j = i + d->random(count - i);
+          std::swap(candidates[i], candidates[j]);
+          relaxed[candidates[i]] = true;
+        }
+      }
+
+      // Fix everything outside of the neighbourhood and constrain the 
+      // objective.
+      MSpace* home = static_cast<MSpace*>(d->base->clone());
+      home->constrain(d->best);
+      for (unsigned int i = 0; i < count && !home->failed(); i++) {
+        if (relaxed[i]) continue;
+        if (i < int_count) {
+          Gecode::IntVar* x = d->best->int_var(d->int_ids[i]);
+          if (x->assigned()) {
+            rel(home, *home->int_var(d->int_ids[i]), IRT_EQ, x->val());
+          }
+        } else {
+          Gecode::BoolVar* x = d->best->bool_var(d->bool_ids[i - int_count]);
+          if (x->assigned()) {
+            rel(home, *home->bool_var(d->bool_ids[i - int_count]), IRT_EQ, 
+              x->val());
+          }
+        }
+      }
+
+      Gecode::DFS<MSpace> e(home, o);
+      MSpace* solution = e.next();
+      bool exhausted = !e.stopped();
+      d->add_statistics(e.statistics());
+      Private::dispose(home);
+
+      if (solution != 0) {
+        Private::dispose(d->best);
+        d->best = solution;
+        return static_cast<MSpace*>(d->best->clone());
+      }
+      if (exhausted) {
+        if (d->relaxed_count == count) {
+          // Nothing was fixed, so there is no better solution.
+          return 0;
+        }
+        if (++d->exhausted_count >= count) {
+          d->relaxed_count++;
+          d->exhausted_count = 0;
+        }
+      } else {
+        d->exhausted_count = 0;
+      }
+    }
+    return 0;
+  }
+
+  bool MLNS::stopped() {
+    return d->stopped;
+  }
+
+  Gecode::Search::Statistics MLNS::statistics() {
+    return d->stats;
+  }
 }
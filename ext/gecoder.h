@@ -22,6 +22,8 @@
 
 #include <ruby.h>
 
+#include <string>
+
 #include <gecode/kernel.hh>
 #include <gecode/int.hh>
 #include <gecode/search.hh>
@@ -29,6 +31,8 @@
 #include <gecode/set.hh>
 
 #include "vararray.h"
+#include "pseudoboolean.h"
+#include "guidedbranch.h"
 
 namespace Gecode {
   class MSpace : public Space {
@@ -41,12 +45,21 @@ namespace Gecode {
       int new_int_var(int min, int max);
       int new_int_var(IntSet domain);
       Gecode::IntVar* int_var(int id);
+      int int_var_count();
 
       int new_bool_var();
       Gecode::BoolVar* bool_var(int id);
+      int bool_var_count();
 
       int new_set_var(const IntSet& glb, const IntSet& lub, unsigned int card_min, unsigned int card_max);
       Gecode::SetVar* set_var(int id);
+      int set_var_count();
+
+      std::string fingerprint();
+
+      void set_guide(const IntArgs& int_values, const IntArgs& bool_values);
+      bool guided_int_val(int id, int& val) const;
+      bool guided_bool_val(int id, int& val) const;
 
       void gc_mark();
 
@@ -56,6 +69,9 @@ namespace Gecode {
       Gecode::IntVarArray int_variables;
       Gecode::BoolVarArray bool_variables;
       Gecode::SetVarArray set_variables;
+
+      struct Guide;
+      Guide* guide;
   };
   
   class MDFS : public Gecode::DFS<MSpace> {
@@ -70,6 +86,31 @@ namespace Gecode {
       ~MBAB();
   };
 
+  /*
+   * The ways in which MLNS can pick the variables to relax.
+   */
+  enum LNSNeighbourhood {
+    LNS_RANDOM, ///< Relax variables picked uniformly at random.
+    LNS_BLOCK   ///< Relax a block of variables next to each other.
+  };
+
+  class MLNS {
+    public:
+      MLNS(MSpace* space, const Search::Options &o, 
+        const IntArgs& int_ids, const IntArgs& bool_ids,
+        LNSNeighbourhood neighbourhood, int relaxation, int fails, 
+        int iterations, int seed);
+      ~MLNS();
+
+      MSpace* next();
+      bool stopped();
+      Gecode::Search::Statistics statistics();
+
+    private:
+      struct Private;
+      Private *const d;
+  };
+
   namespace Search {
     class MStop : public Gecode::Search::Stop {
       public:
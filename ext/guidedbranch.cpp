@@ -0,0 +1,274 @@
+/**
+ * Gecode/R, a Ruby interface to Gecode.
+ * Copyright (C) 2007 The Gecode/R development team.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ **/
+
+#include "gecoder.h"
+#include "guidedbranch.h"
+
+#include <gecode/int/branch.hh>
+
+namespace Gecode { namespace GuidedBranch {
+  /**
+   * Describes a branch on the view at a position. Guided descriptions 
+   * branch on whether the view is equal to the guided value, the others 
+   * on the value picked by the value selection.
+   */
+  template <class Val>
+  class Desc : public PosValDesc<Val,2> {
+    protected:
+      const bool _guided;
+      const int _guided_val;
+    public:
+      Desc(const Branching* b, int p, const Val& n, bool guided, 
+          int guided_val) 
+        : PosValDesc<Val,2>(b, p, n), _guided(guided), 
+          _guided_val(guided_val) {
+      }
+
+      bool guided() const {
+        return _guided;
+      }
+
+      int guided_val() const {
+        return _guided_val;
+      }
+
+      virtual size_t size() const {
+        return sizeof(Desc<Val>);
+      }
+  };
+
+  /// Looks up the guided value of the integer variable with the id.
+  static bool
+  guided_val(const Space* home, Int::IntView, int id, int& val) {
+    return static_cast<const MSpace*>(home)->guided_int_val(id, val);
+  }
+
+  /// Looks up the guided value of the boolean variable with the id.
+  static bool
+  guided_val(const Space* home, Int::BoolView, int id, int& val) {
+    return static_cast<const MSpace*>(home)->guided_bool_val(id, val);
+  }
+
+  /**
+   * Branching that selects views like ViewValBranching, but that prefers
+   * the guided value of the selected view over the value selection.
+   */
+  template <class View, class Val, class ViewSel, class ValSel>
+  class GuidedBranching : public ViewValBranching<View,Val,ViewSel,ValSel> {
+    protected:
+      using ViewValBranching<View,Val,ViewSel,ValSel>::x;
+      using ViewValBranching<View,Val,ViewSel,ValSel>::start;
+      /// The identifiers of the variables, in the same order as x.
+      int* ids;
+
+      GuidedBranching(Space* home, bool share, GuidedBranching& b) 
+        : ViewValBranching<View,Val,ViewSel,ValSel>(home, share, b) {
+        ids = static_cast<int*>(home->alloc(sizeof(int) * x.size()));
+        for (int i = x.size(); i--; )
+          ids[i] = b.ids[i];
+      }
+
+    public:
+      GuidedBranching(Space* home, ViewArray<View>& x0, const IntArgs& ids0) 
+        : ViewValBranching<View,Val,ViewSel,ValSel>(home, x0) {
+        ids = static_cast<int*>(home->alloc(sizeof(int) * x.size()));
+        for (int i = x.size(); i--; )
+          ids[i] = ids0[i];
+      }
+
+      virtual Actor* copy(Space* home, bool share) {
+        return new (home) GuidedBranching(home, share, *this);
+      }
+
+      virtual const BranchingDesc* description(const Space* home) const {
+        // Select the view in the same way as ViewValBranching.
+        ViewSel vs;
+        ValSel vl;
+        int i = start;
+        int b = i++;
+        if (vs.init(home, x[b]) != VSS_COMMIT) {
+          for (; i < x.size(); i++) {
+            if (x[i].assigned())
+              continue;
+            ViewSelStatus status = vs.select(home, x[i]);
+            if (status == VSS_SELECT) {
+              b = i;
+            } else if (status == VSS_COMMIT) {
+              b = i;
+              break;
+            }
+          }
+        }
+
+        int val = 0;
+        bool guided = guided_val(home, x[b], ids[b], val) && x[b].in(val);
+        return new Desc<Val>(this, b, vl.val(home, x[b]), guided, val);
+      }
+
+      virtual ExecStatus commit(Space* home, const BranchingDesc* d, 
+          unsigned int a) {
+        const Desc<Val>* desc = static_cast<const Desc<Val>*>(d);
+        View view = x[desc->pos()];
+        ModEvent me;
+        if (desc->guided()) {
+          me = (a == 0) ? view.eq(home, desc->guided_val()) 
+            : view.nq(home, desc->guided_val());
+        } else {
+          ValSel vs;
+          me = vs.tell(home, a, view, desc->val());
+        }
+        return me_failed(me) ? ES_FAILED : ES_OK;
+      }
+  };
+
+  /// Creates the integer branching with the specified value selection.
+  template <template <class> class ViewSel>
+  static void
+  create(Space* home, ViewArray<Int::IntView>& x, const IntArgs& ids,
+      IntValBranch vals) {
+    using namespace Int::Branch;
+    typedef Int::IntView View;
+    if (home->failed())
+      return;
+    switch (vals) {
+      case INT_VAL_MIN:
+        (void) new (home) 
+          GuidedBranching<View,int,ViewSel<View>,ValMin<View> >(home, x, ids);
+        break;
+      case INT_VAL_MED:
+        (void) new (home) 
+          GuidedBranching<View,int,ViewSel<View>,ValMed<View> >(home, x, ids);
+        break;
+      case INT_VAL_MAX:
+        (void) new (home) 
+          GuidedBranching<View,int,ViewSel<View>,ValMax<View> >(home, x, ids);
+        break;
+      case INT_VAL_SPLIT_MIN:
+        (void) new (home) GuidedBranching<View,int,ViewSel<View>,
+          ValSplitMin<View> >(home, x, ids);
+        break;
+      case INT_VAL_SPLIT_MAX:
+        (void) new (home) GuidedBranching<View,int,ViewSel<View>,
+          ValSplitMax<View> >(home, x, ids);
+        break;
+      default:
+        throw Int::UnknownBranching("guided_branch");
+    }
+  }
+
+  /// Creates the boolean branching with the specified value selection.
+  template <template <class> class ViewSel>
+  static void
+  create(Space* home, ViewArray<Int::BoolView>& x, const IntArgs& ids,
+      IntValBranch vals) {
+    using namespace Int::Branch;
+    typedef Int::BoolView View;
+    if (home->failed())
+      return;
+    switch (vals) {
+      case INT_VAL_MIN:
+      case INT_VAL_MED:
+      case INT_VAL_SPLIT_MIN:
+        (void) new (home) GuidedBranching<View,NoValue,ViewSel<View>,
+          ValZeroOne<View> >(home, x, ids);
+        break;
+      case INT_VAL_MAX:
+      case INT_VAL_SPLIT_MAX:
+        (void) new (home) GuidedBranching<View,NoValue,ViewSel<View>,
+          ValOneZero<View> >(home, x, ids);
+        break;
+      default:
+        throw Int::UnknownBranching("guided_branch");
+    }
+  }
+}}
+
+namespace Gecode {
+  void guided_branch(Space* home, const IntVarArgs& x, const IntArgs& ids,
+      IntVarBranch vars, IntValBranch vals) {
+    using namespace Int::Branch;
+    using GuidedBranch::create;
+    if (x.size() != ids.size())
+      throw Int::ArgumentSizeMismatch("guided_branch");
+    ViewArray<Int::IntView> xv(home, x);
+    switch (vars) {
+      case INT_VAR_NONE: create<ByNone>(home, xv, ids, vals); break;
+      case INT_VAR_MIN_MIN: create<ByMinMin>(home, xv, ids, vals); break;
+      case INT_VAR_MIN_MAX: create<ByMinMax>(home, xv, ids, vals); break;
+      case INT_VAR_MAX_MIN: create<ByMaxMin>(home, xv, ids, vals); break;
+      case INT_VAR_MAX_MAX: create<ByMaxMax>(home, xv, ids, vals); break;
+      case INT_VAR_SIZE_MIN: create<BySizeMin>(home, xv, ids, vals); break;
+      case INT_VAR_SIZE_MAX: create<BySizeMax>(home, xv, ids, vals); break;
+      case INT_VAR_DEGREE_MIN: 
+        create<ByDegreeMin>(home, xv, ids, vals); break;
+      case INT_VAR_DEGREE_MAX: 
+        create<ByDegreeMax>(home, xv, ids, vals); break;
+      case INT_VAR_SIZE_DEGREE_MIN: 
+        create<BySizeDegreeMin>(home, xv, ids, vals); break;
+      case INT_VAR_SIZE_DEGREE_MAX: 
+        create<BySizeDegreeMax>(home, xv, ids, vals); break;
+      case INT_VAR_REGRET_MIN_MIN: 
+        create<ByRegretMinMin>(home, xv, ids, vals); break;
+      case INT_VAR_REGRET_MIN_MAX: 
+        create<ByRegretMinMax>(home, xv, ids, vals); break;
+      case INT_VAR_REGRET_MAX_MIN: 
+        create<ByRegretMaxMin>(home, xv, ids, vals); break;
+      case INT_VAR_REGRET_MAX_MAX: 
+        create<ByRegretMaxMax>(home, xv, ids, vals); break;
+      default:
+        throw Int::UnknownBranching("guided_branch");
+    }
+  }
+
+  void guided_branch(Space* home, const BoolVarArgs& x, const IntArgs& ids,
+      IntVarBranch vars, IntValBranch vals) {
+    using namespace Int::Branch;
+    using GuidedBranch::create;
+    if (x.size() != ids.size())
+      throw Int::ArgumentSizeMismatch("guided_branch");
+    // The view selections that make sense for booleans, as in 
+    // Gecode::branch.
+    ViewArray<Int::BoolView> xv(home, x);
+    switch (vars) {
+      case INT_VAR_NONE:
+      case INT_VAR_MIN_MIN:
+      case INT_VAR_MIN_MAX:
+      case INT_VAR_MAX_MIN:
+      case INT_VAR_MAX_MAX:
+      case INT_VAR_SIZE_MIN:
+      case INT_VAR_SIZE_MAX:
+      case INT_VAR_REGRET_MIN_MIN:
+      case INT_VAR_REGRET_MIN_MAX:
+      case INT_VAR_REGRET_MAX_MIN:
+      case INT_VAR_REGRET_MAX_MAX:
+        create<ByNone>(home, xv, ids, vals); 
+        break;
+      case INT_VAR_DEGREE_MIN:
+      case INT_VAR_SIZE_DEGREE_MAX:
+        create<ByDegreeMinNoTies>(home, xv, ids, vals); 
+        break;
+      case INT_VAR_DEGREE_MAX:
+      case INT_VAR_SIZE_DEGREE_MIN:
+        create<ByDegreeMaxNoTies>(home, xv, ids, vals); 
+        break;
+      default:
+        throw Int::UnknownBranching("guided_branch");
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/**
+ * Gecode/R, a Ruby interface to Gecode.
+ * Copyright (C) 2007 The Gecode/R development team.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ **/
+
+#ifndef __GECODER_GUIDEDBRANCH_H
+#define __GECODER_GUIDEDBRANCH_H
+
+#include <gecode/kernel.hh>
+#include <gecode/int.hh>
+
+namespace Gecode {
+  /**
+   * Branches on the variables like Gecode::branch, except that a variable
+   * is first tried with its value in the space's guide (see 
+   * MSpace::set_guide), if there is one and it is still in the 
+   * variable's domain. The alternative is then that the variable is not 
+   * equal to that value. Variables without guided values use the 
+   * specified value selection.
+   *
+   * The identifiers of the variables in the home space (which must be an 
+   * MSpace) are given by ids, in the same order as x.
+   */
+  void guided_branch(Space* home, const IntVarArgs& x, const IntArgs& ids,
+    IntVarBranch vars, IntValBranch vals);
+  void guided_branch(Space* home, const BoolVarArgs& x, const IntArgs& ids,
+    IntVarBranch vars, IntValBranch vals);
+}
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * Gecode/R, a Ruby interface to Gecode.
+ * Copyright (C) 2007 The Gecode/R development team.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ **/
+
+#include "pseudoboolean.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace Gecode { namespace PseudoBoolean {
+  /**
+   * A literal together with its (positive) coefficient. The literal is the 
+   * negation of the view if neg is set.
+   */
+  struct Term {
+    Int::BoolView x;
+    int a;
+    bool neg;
+  };
+
+  /// Orders terms by decreasing coefficient.
+  static bool
+  larger_coefficient(const Term& t1, const Term& t2) {
+    return t1.a > t2.a;
+  }
+
+  /// Advisor that tells the propagator what a view's term contributes.
+  class TermAdvisor : public ViewAdvisor<Int::BoolView> {
+    public:
+      int a;
+      bool neg;
+
+      TermAdvisor(Space* home, Propagator* p, Council<TermAdvisor>& c,
+        const Term& t) 
+        : ViewAdvisor<Int::BoolView>(home, p, c, t.x), a(t.a), neg(t.neg) {
+      }
+
+      TermAdvisor(Space* home, bool share, TermAdvisor& ta) 
+        : ViewAdvisor<Int::BoolView>(home, share, ta), a(ta.a), neg(ta.neg) {
+      }
+
+      /// Checks whether the literal of the (assigned) view is true.
+      bool literal_true() const {
+        return view().one() != neg;
+      }
+  };
+
+  /**
+   * Propagator for sum(a[i]*l[i]) <= c where all a[i] are positive and 
+   * l[i] are literals. 
+   *
+   * The slack (c minus the coefficients of the true literals) is 
+   * maintained by the advisors, so an assignment costs constant time. The 
+   * propagator itself is only scheduled when the largest coefficient that 
+   * might still be unassigned exceeds the slack, in which case it sets 
+   * literals to false starting from the largest coefficient.
+   */
+  class Lq : public Propagator {
+    protected:
+      /// The terms, sorted by decreasing coefficient.
+      Term* t;
+      /// The number of terms.
+      int n;
+      /// All terms before this index are either assigned or have been fixed.
+      int lo;
+      /// The bound minus the coefficients of the true literals.
+      int slack;
+      /// The sum of the coefficients of the unassigned literals.
+      int rest;
+      Council<TermAdvisor> co;
+
+      Lq(Space* home, bool share, Lq& p) 
+        : Propagator(home, share, p), n(0), lo(0), slack(p.slack), 
+          rest(p.rest) {
+        co.update(home, share, p.co);
+        // Only the unassigned terms are kept, in the same order.
+        t = 0;
+        if (p.n > p.lo)
+          t = static_cast<Term*>(home->alloc(sizeof(Term) * (p.n - p.lo)));
+        for (int i = p.lo; i < p.n; i++) {
+          if (p.t[i].x.none()) {
+            t[n] = p.t[i];
+            t[n].x.update(home, share, p.t[i].x);
+            n++;
+          }
+        }
+      }
+
+    public:
+      /// Creates the propagator. The terms must be unassigned and sorted.
+      Lq(Space* home, const Term* terms, int n0, int c, int sum) 
+        : Propagator(home), n(n0), lo(0), slack(c), rest(sum), co(home) {
+        t = static_cast<Term*>(home->alloc(sizeof(Term) * n));
+        for (int i = 0; i < n; i++) {
+          t[i] = terms[i];
+          (void) new (home) TermAdvisor(home, this, co, t[i]);
+        }
+      }
+
+      virtual Actor* copy(Space* home, bool share) {
+        return new (home) Lq(home, share, *this);
+      }
+
+      virtual PropCost cost(ModEventDelta) const {
+        return cost_lo(n - lo, PC_LINEAR_LO);
+      }
+
+      virtual ExecStatus advise(Space* home, Advisor* _a, const Delta*) {
+        TermAdvisor* a = static_cast<TermAdvisor*>(_a);
+        rest -= a->a;
+        bool wake = false;
+        if (a->literal_true()) {
+          slack -= a->a;
+          if (slack < 0)
+            return ES_FAILED;
+          wake = (lo < n) && (t[lo].a > slack);
+        }
+        if (rest <= slack)
+          wake = true;
+        return wake ? ES_SUBSUMED_NOFIX(a, home, co) 
+          : ES_SUBSUMED_FIX(a, home, co);
+      }
+
+      virtual ExecStatus propagate(Space* home, ModEventDelta) {
+        while ((lo < n) && (t[lo].a > slack)) {
+          if (t[lo].x.none()) {
+            GECODE_ME_CHECK(t[lo].neg ? t[lo].x.one_none(home) 
+              : t[lo].x.zero_none(home));
+          }
+          lo++;
+        }
+        if (rest <= slack)
+          return ES_SUBSUMED(this, dispose(home));
+        return ES_FIX;
+      }
+
+      virtual size_t dispose(Space* home) {
+        co.dispose(home);
+        (void) Propagator::dispose(home);
+        return sizeof(*this);
+      }
+
+      static Support::Symbol ati() {
+        return Support::Symbol("Gecode::PseudoBoolean::Lq");
+      }
+
+      /// Describes the remaining terms. Negated literals get negative 
+      /// coefficients.
+      virtual Reflection::ActorSpec spec(const Space* home, 
+          Reflection::VarMap& m) const {
+        Reflection::ActorSpec s(ati());
+        Reflection::ArrayArg* xs = Reflection::Arg::newArray(n - lo);
+        Reflection::IntArrayArg* as = Reflection::Arg::newIntArray(n - lo);
+        for (int i = lo; i < n; i++) {
+          (*xs)[i - lo] = t[i].x.spec(home, m);
+          (*as)[i - lo] = t[i].neg ? -t[i].a : t[i].a;
+        }
+        return s << xs << as << slack;
+      }
+  };
+
+  /**
+   * Posts sum(sign*a[i]*x[i]) <= c. The caller has checked that no 
+   * intermediate sum can overflow.
+   */
+  static void
+  post_lq(Space* home, const IntArgs& a, const BoolVarArgs& x, int sign,
+      double c) {
+    // Merge variables that occur more than once into a single coefficient 
+    // (in the order of their first occurrence), so that every view ends up 
+    // in at most one term. The caller's overflow check still holds since 
+    // merging can not increase the sum of the absolute values.
+    std::vector<Int::BoolView> views;
+    std::vector<int> coefficients;
+    std::map<Int::BoolVarImp*, unsigned int> positions;
+    views.reserve(x.size());
+    coefficients.reserve(x.size());
+    for (int i = 0; i < x.size(); i++) {
+      Int::BoolView v(x[i]);
+      std::map<Int::BoolVarImp*, unsigned int>::iterator it = 
+        positions.find(v.var());
+      if (it == positions.end()) {
+        positions[v.var()] = views.size();
+        views.push_back(v);
+        coefficients.push_back(sign * a[i]);
+      } else {
+        coefficients[it->second] += sign * a[i];
+      }
+    }
+
+    // Normalise to positive coefficients by replacing a*x with a - a*!x 
+    // for negative a, and drop the assigned variables.
+    std::vector<Term> terms;
+    terms.reserve(views.size());
+    double sum = 0;
+    for (unsigned int i = 0; i < views.size(); i++) {
+      int ai = coefficients[i];
+      Int::BoolView v = views[i];
+      if (ai == 0 || v.zero())
+        continue;
+      if (v.one()) {
+        c -= ai;
+        continue;
+      }
+      Term term;
+      term.x = v;
+      if (ai > 0) {
+        term.a = ai;
+        term.neg = false;
+      } else {
+        term.a = -ai;
+        term.neg = true;
+        c -= ai;
+      }
+      sum += term.a;
+      terms.push_back(term);
+    }
+    if (c < 0) {
+      home->fail();
+      return;
+    }
+    if (sum <= c)
+      return;
+
+    // New propagators are not scheduled, so everything that the propagator 
+    // would do right away is done here.
+    std::sort(terms.begin(), terms.end(), larger_coefficient);
+    unsigned int first = 0;
+    while (first < terms.size() && terms[first].a > c) {
+      Term& term = terms[first];
+      GECODE_ME_FAIL(home, term.neg ? term.x.one(home) : term.x.zero(home));
+      sum -= term.a;
+      first++;
+    }
+    if (sum <= c)
+      return;
+    (void) new (home) Lq(home, &terms[first], terms.size() - first, 
+      static_cast<int>(c), static_cast<int>(sum));
+  }
+}}
+
+namespace Gecode {
+  void pseudo_boolean_linear(Space* home, const IntArgs& a, 
+      const BoolVarArgs& x, IntRelType r, int c, IntConLevel icl, 
+      PropKind pk) {
+    if (a.size() != x.size())
+      throw Int::ArgumentSizeMismatch("pseudo_boolean_linear");
+    if (home->failed()) 
+      return;
+
+    double bound = std::abs(static_cast<double>(c)) + 1;
+    for (int i = 0; i < a.size(); i++)
+      bound += std::abs(static_cast<double>(a[i]));
+    if (r == IRT_NQ || bound > Int::Limits::max) {
+      linear(home, a, x, r, c, icl, pk);
+      return;
+    }
+
+    switch (r) {
+      case IRT_EQ:
+        PseudoBoolean::post_lq(home, a, x, 1, c);
+        if (!home->failed())
+          PseudoBoolean::post_lq(home, a, x, -1, -c);
+        break;
+      case IRT_LQ:
+        PseudoBoolean::post_lq(home, a, x, 1, c);
+        break;
+      case IRT_LE:
+        PseudoBoolean::post_lq(home, a, x, 1, c - 1.0);
+        break;
+      case IRT_GQ:
+        PseudoBoolean::post_lq(home, a, x, -1, -c);
+        break;
+      case IRT_GR:
+        PseudoBoolean::post_lq(home, a, x, -1, -(c + 1.0));
+        break;
+      default:
+        throw Int::UnknownRelation("pseudo_boolean_linear");
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/**
+ * Gecode/R, a Ruby interface to Gecode.
+ * Copyright (C) 2007 The Gecode/R development team.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ **/
+
+#ifndef __GECODER_PSEUDOBOOLEAN_H
+#define __GECODER_PSEUDOBOOLEAN_H
+
+#include <gecode/kernel.hh>
+#include <gecode/int.hh>
+
+namespace Gecode {
+  /**
+   * Posts the constraint sum(a[i]*x[i]) r c using a pseudo-Boolean
+   * propagator. The terms are kept sorted by decreasing coefficient and
+   * the propagator only maintains the slack incrementally, so that it is
+   * only woken up when the slack drops below the largest coefficient of an
+   * unassigned variable. This scales better than the generic linear
+   * propagators when there are many terms with differing coefficients.
+   *
+   * Relations other than IRT_NQ are decomposed into one or two
+   * propagators. IRT_NQ, and constraints whose coefficients could
+   * overflow, are posted using Gecode::linear instead.
+   */
+  void pseudo_boolean_linear(Space* home, const IntArgs& a, 
+    const BoolVarArgs& x, IntRelType r, int c, IntConLevel icl, 
+    PropKind pk);
+}
+
+#endif
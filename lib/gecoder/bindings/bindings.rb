@@ -51,6 +51,8 @@ Gecode::IntArgs ruby2Gecode_IntArgs(VALUE arr, int argn)
 custom_mark_definitions =<<-"end_custom_definition"
   static void Gecode_MSpace_custom_mark(void *p) {
     Gecode_MSpace_mark(p);
+    // Spaces deleted by the LNS engine are detached from their objects.
+    if (p == 0) return;
     ((Gecode::MSpace*)p)->gc_mark();
   }
   
@@ -123,6 +125,11 @@ Rust::Bindings::create_bindings Rust::Bindings::LangCxx, "gecode" do |b|
       enum.add_value "SET_VAL_MAX"
     end
     
+    ns.add_enum "LNSNeighbourhood" do |enum|
+      enum.add_value "LNS_RANDOM"
+      enum.add_value "LNS_BLOCK"
+    end
+    
     ns.add_enum "IntRelType" do |enum|
       enum.add_value "IRT_EQ"
       enum.add_value "IRT_NQ"
@@ -392,6 +399,17 @@ Rust::Bindings::create_bindings Rust::Bindings::LangCxx, "gecode" do |b|
         method.add_parameter "int", "id"
       end
 
+      klass.add_method "int_var_count", "int"
+      klass.add_method "bool_var_count", "int"
+      klass.add_method "set_var_count", "int"
+      
+      klass.add_method "fingerprint", "std::string"
+
+      klass.add_method "set_guide" do |method|
+        method.add_parameter "Gecode::IntArgs", "int_values"
+        method.add_parameter "Gecode::IntArgs", "bool_values"
+      end
+
       klass.add_method "clone", "Gecode::MSpace *" do |method|
         method.add_parameter "bool", "shared"
       end
@@ -647,6 +665,25 @@ Rust::Bindings::create_bindings Rust::Bindings::LangCxx, "gecode" do |b|
       klass.add_method "stopped", "bool"
       klass.add_method "statistics", "Gecode::Search::Statistics"
     end
+    
+    ns.add_cxx_class "MLNS" do |klass|
+      klass.bindname = "LNS"
+      klass.add_constructor do |method|
+        method.add_parameter "Gecode::MSpace *", "s"
+        method.add_parameter "Gecode::Search::Options", "o"
+        method.add_parameter "Gecode::IntArgs", "int_ids"
+        method.add_parameter "Gecode::IntArgs", "bool_ids"
+        method.add_parameter "Gecode::LNSNeighbourhood", "neighbourhood"
+        method.add_parameter "int", "relaxation"
+        method.add_parameter "int", "fails"
+        method.add_parameter "int", "iterations"
+        method.add_parameter "int", "seed"
+      end
+      
+      klass.add_method "next", "Gecode::MSpace *"
+      klass.add_method "stopped", "bool"
+      klass.add_method "statistics", "Gecode::Search::Statistics"
+    end
 
     ns.add_cxx_class "DFA" do |klass|
       klass.add_constructor
@@ -991,6 +1028,26 @@ Rust::Bindings::create_bindings Rust::Bindings::LangCxx, "gecode" do |b|
       func.add_parameter "Gecode::IntValBranch", "vals"
     end
     
+    ns.add_function "guided_branch" do |func|
+      func.add_parameter "Gecode::MSpace *", "home"
+      func.add_parameter "Gecode::MIntVarArray *", "iva" do |param|
+        param.custom_conversion = "*ruby2Gecode_MIntVarArrayPtr(argv[1], 2)->ptr()"
+      end
+      func.add_parameter "Gecode::IntArgs", "ids"
+      func.add_parameter "Gecode::IntVarBranch", "vars"
+      func.add_parameter "Gecode::IntValBranch", "vals"
+    end
+    
+    ns.add_function "guided_branch" do |func|
+      func.add_parameter "Gecode::MSpace *", "home"
+      func.add_parameter "Gecode::MBoolVarArray *", "iva" do |param|
+        param.custom_conversion = "*ruby2Gecode_MBoolVarArrayPtr(argv[1], 2)->ptr()"
+      end
+      func.add_parameter "Gecode::IntArgs", "ids"
+      func.add_parameter "Gecode::IntVarBranch", "vars"
+      func.add_parameter "Gecode::IntValBranch", "vals"
+    end
+    
     ns.add_function "branch" do |func|
       func.add_parameter "Gecode::MSpace *", "home"
       func.add_parameter "Gecode::MSetVarArray *", "sva" do |param|
@@ -1305,7 +1362,19 @@ Rust::Bindings::create_bindings Rust::Bindings::LangCxx, "gecode" do |b|
       func.add_parameter "Gecode::IntConLevel", "icl"
       func.add_parameter "Gecode::PropKind", "pk"
     end
-    
+
+    ns.add_function "pseudo_boolean_linear", "void" do |func|
+      func.add_parameter "Gecode::MSpace*", "home"
+      func.add_parameter "Gecode::IntArgs", "a"
+      func.add_parameter "Gecode::MBoolVarArray *", "x" do |param|
+        param.custom_conversion = "*ruby2Gecode_MBoolVarArrayPtr(x, 3)->ptr()"
+      end
+      func.add_parameter "Gecode::IntRelType", "r"
+      func.add_parameter "int", "c"
+      func.add_parameter "Gecode::IntConLevel", "icl"
+      func.add_parameter "Gecode::PropKind", "pk"
+    end
+
     ns.add_function "extensional", "void" do |func|
       func.add_parameter "Gecode::MSpace*", "home"
       func.add_parameter "Gecode::MIntVarArray *", "x" do |param|
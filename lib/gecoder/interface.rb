@@ -4,6 +4,7 @@ require 'gecoder/interface/mixin'
 require 'gecoder/interface/mixin'
 require 'gecoder/interface/mixin'
 require 'gecoder/interface/search'
+require 'gecoder/interface/solution_cache'
 require 'gecoder/interface/constraints'
 require 'gecoder/interface/variables'
 require 'gecoder/interface/enum_wrapper'
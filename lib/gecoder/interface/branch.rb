@@ -72,10 +72,12 @@ module Gecode
         add_branch(variables.to_int_enum, options,
           Constants::BRANCH_INT_VAR_CONSTANTS, 
           Constants::BRANCH_INT_VALUE_CONSTANTS)
+        branched_variable_ids[:int].concat variables.map{ |var| var.index }
       elsif variables.respond_to? :to_bool_enum
         add_branch(variables.to_bool_enum, options, 
           Constants::BRANCH_INT_VAR_CONSTANTS, 
           Constants::BRANCH_INT_VALUE_CONSTANTS)
+        branched_variable_ids[:bool].concat variables.map{ |var| var.index }
       elsif variables.respond_to? :to_set_enum
         add_branch(variables.to_set_enum, options, 
           Constants::BRANCH_SET_VAR_CONSTANTS, 
@@ -155,8 +157,28 @@ module Gecode
 
       # Add the branching as a gecode interaction.
       add_interaction do
-        Gecode::Raw.branch(active_space, variables.bind_array, 
-          branch_var_hash[var_strat], branch_value_hash[val_strat])
+        post_branch(variables, branch_var_hash[var_strat], 
+          branch_value_hash[val_strat])
+      end
+    end
+
+    # Returns a hash with the identifiers of the integer (:int) and boolean 
+    # (:bool) variables that have been branched on.
+    def branched_variable_ids
+      @gecoder_mixin_branched_variable_ids ||= {:int => [], :bool => []}
+    end
+
+    # Posts a branching on the variables to the active space. Integer and 
+    # boolean variables use guided branchings, which try the values from a
+    # previous solution first when #solve! is warm started.
+    def post_branch(variables, var_strat, val_strat)
+      if variables.respond_to? :to_set_enum
+        Gecode::Raw.branch(active_space, variables.bind_array, var_strat, 
+          val_strat)
+      else
+        ids = variables.map{ |variable| variable.index }
+        Gecode::Raw.guided_branch(active_space, variables.bind_array, ids,
+          var_strat, val_strat)
       end
     end
   end
@@ -99,10 +99,72 @@ module Gecode::Bool
 
   # A module that gathers the classes and modules used in linear constraints.
   module Linear #:nodoc:
+    # The number of boolean terms above which a linear relation without
+    # reification is posted using the pseudo-Boolean propagator rather 
+    # than MiniModel's linear expressions.
+    PSEUDO_BOOLEAN_THRESHOLD = 32
+
+    class <<self
+      # The number of terms from which the pseudo-Boolean propagator is 
+      # used. Defaults to PSEUDO_BOOLEAN_THRESHOLD, setting it to nil 
+      # disables the propagator (used by specs and benchmarks to compare 
+      # against MiniModel).
+      attr_accessor :pseudo_boolean_threshold
+    end
+    self.pseudo_boolean_threshold = PSEUDO_BOOLEAN_THRESHOLD
+
+    # Flattens +lhs+ - +rhs+ into an array of [bool operand, coefficient] 
+    # pairs and a constant. Returns nil if the expressions are not linear.
+    # The trees are traversed without recursion since they tend to be as
+    # deep as they have terms.
+    def self.bool_linear_terms(lhs, rhs)
+      terms = []
+      constant = 0
+      stack = [[rhs, -1], [lhs, 1]]
+      until stack.empty?
+        node, factor = stack.pop
+        if node.kind_of? ExpressionNode
+          if node.value.kind_of? Fixnum
+            constant += factor * node.value
+          else
+            terms << [node.value, factor]
+          end
+        elsif node.kind_of? ExpressionTree
+          case node.operation
+          when :+
+            stack << [node.right, factor] << [node.left, factor]
+          when :-
+            stack << [node.right, -factor] << [node.left, factor]
+          when :*
+            right = node.right
+            unless right.kind_of?(ExpressionNode) and 
+                right.value.kind_of?(Fixnum)
+              return nil
+            end
+            stack << [node.left, factor * right.value]
+          else
+            return nil
+          end
+        else
+          return nil
+        end
+      end
+      return terms, constant
+    end
+
     class LinearRelationConstraint < Gecode::ReifiableConstraint #:nodoc:
       def post
         lhs, rhs, relation_type, reif_var = 
           @params.values_at(:lhs, :rhs, :relation_type, :reif)
+        if reif_var.nil?
+          terms, constant = Linear.bool_linear_terms(lhs, rhs)
+          threshold = Linear.pseudo_boolean_threshold
+          if terms and threshold and terms.size >= threshold
+            post_pseudo_boolean(terms, constant, relation_type)
+            return
+          end
+        end
+
         reif_var = reif_var.to_bool_var.bind if reif_var.respond_to? :to_bool_var
         final_exp = (lhs.to_minimodel_lin_exp - rhs.to_minimodel_lin_exp)
         if reif_var.nil?
@@ -113,6 +175,17 @@ module Gecode::Bool
             *propagation_options)
         end
       end
+
+      private
+
+      # Posts sum(coefficient*operand) + constant <relation_type> 0.
+      def post_pseudo_boolean(terms, constant, relation_type)
+        coefficients = terms.map{ |operand, coefficient| coefficient }
+        variables = terms.map{ |operand, coefficient| operand.to_bool_var }
+        Gecode::Raw::pseudo_boolean_linear(@model.active_space, coefficients,
+          @model.wrap_enum(variables).bind_array, relation_type, -constant,
+          *propagation_options)
+      end
     end
 
     # Describes a binary tree of expression nodes which together form a linear 
@@ -120,6 +193,9 @@ module Gecode::Bool
     class ExpressionTree < Gecode::Int::ShortCircuitRelationsOperand #:nodoc:
       include Gecode::Bool::BoolLinearOperations
       attr :model
+      attr :left
+      attr :right
+      attr :operation
 
       # Constructs a new expression with the specified operands.
       def initialize(left_node, right_node, operation)
@@ -176,6 +252,7 @@ module Gecode::Bool
     # Describes a single node in a linear expression.
     class ExpressionNode #:nodoc:
       attr :model
+      attr :value
     
       def initialize(value, model = nil)
         unless value.respond_to?(:to_bool_var) or value.kind_of?(Fixnum)
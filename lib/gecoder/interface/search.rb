@@ -27,13 +27,58 @@ module Gecode
     #               allowed to use when searching for a solution. If it can 
     #               not find a solution fast enough, then 
     #               Gecode::SearchAbortedError is raised.
+    # [:warm_start] A model whose variables are assigned by a previous 
+    #               search, typically the model itself. The search then
+    #               starts over from the state before any search was made
+    #               (see #reset!), with the constraints added since
+    #               posted on top of it, and tries the previous values of
+    #               the integer and boolean variables before following the 
+    #               value selection given to #branch_on . The search still
+    #               restarts from the root, so what is saved depends on 
+    #               which variables the change touches: re-solving is cheap
+    #               when most of the previous values remain consistent, 
+    #               but if a change rules out a combination of previous 
+    #               values deep in the search, then the search backtracks 
+    #               much like one from scratch.
+    #
+    # ==== Example
+    #
+    #   model.solve!
+    #   model.x.must > model.x.value
+    #   model.solve!(:warm_start => model)
+    #
+    # If a solution cache is used (see Gecode::SolutionCache) and a
+    # solution to an identical model has already been found, then that 
+    # solution is used without searching (#search_stats then returns nil).
+    # The cache is not used when the search is warm started.
     def solve!(options = {})
-      dfs = dfs_engine(options)
+      options = options.dup
+      warm_start = options.delete(:warm_start)
+      guide = nil
+      unless warm_start.nil?
+        unless warm_start.kind_of? Gecode::Mixin
+          raise TypeError, 'Expected a model to warm start from, got ' + 
+            "#{warm_start.class}."
+        end
+        guide = warm_start.solution_values
+        reset!
+      end
+
+      opt_struct = search_options(options)
+      perform_queued_gecode_interactions
+      # The cached solution need not be the one that the guide leads to.
+      key = guide.nil? ? solution_cache_key('solve') : nil
+      return self if restore_cached_solution(key)
+
+      dfs = with_guide(guide) do 
+        Gecode::Raw::DFS.new(selected_space, opt_struct)
+      end
       space = dfs.next
       @gecoder_mixin_statistics = dfs.statistics
       raise Gecode::SearchAbortedError if dfs.stopped
       raise Gecode::NoSolutionError if space.nil?
       self.active_space = space
+      cache_solution(key)
       return self
     end
     
@@ -105,7 +150,40 @@ module Gecode
     #   end
     #
     # Raises Gecode::NoSolutionError if no solution can be found.
-    def optimize!(&block)
+    #
+    # The following options can be specified in a hash with symbols as
+    # keys when calling the method:
+    #
+    # [:engine]        The search engine to use, either :bab (default) 
+    #                  which performs a complete branch and bound search, 
+    #                  or :lns which performs Large Neighbourhood Search. 
+    #                  LNS is not complete, it returns the best solution 
+    #                  found when it runs out of iterations or time.
+    # [:time_limit]    The number of milliseconds that the solver should be
+    #                  allowed to use (only with :lns). The best solution
+    #                  found so far is used when the limit is hit. If no
+    #                  solution has been found then 
+    #                  Gecode::SearchAbortedError is raised.
+    #
+    # The following options can be used to tune the LNS engine:
+    # [:relaxation]    The fraction (a Float between 0 and 1) of the 
+    #                  integer and boolean variables given to #branch_on
+    #                  that should be left free in each neighbourhood. The
+    #                  rest are fixed to their values in the best solution
+    #                  so far. Other variables, and the variable optimized
+    #                  by #maximize! and #minimize!, are never fixed. 
+    #                  Defaults to 0.2 .
+    # [:neighbourhood] How the variables to leave free are selected, either
+    #                  :random (default) or :block which frees variables
+    #                  that are next to each other in the order given to 
+    #                  #branch_on (e.g. rows in a matrix).
+    # [:fail_limit]    The number of failures allowed when searching a 
+    #                  single neighbourhood. Defaults to 100.
+    # [:iterations]    The maximum number of neighbourhoods to search.
+    #                  Defaults to 1000.
+    # [:seed]          The seed used to select neighbourhoods. The same 
+    #                  seed gives the same search. Defaults to 1.
+    def optimize!(options = {}, &block)
       # Execute constraints.
       perform_queued_gecode_interactions
 
@@ -121,21 +199,17 @@ module Gecode
       end
 
       # Perform the search.
-      options = Gecode::Raw::Search::Options.new
-      options.c_d = Gecode::Raw::Search::Config::MINIMAL_DISTANCE
-      options.a_d = Gecode::Raw::Search::Config::ADAPTIVE_DISTANCE
-      options.stop = nil
-      bab = Gecode::Raw::BAB.new(selected_space, options)
-      
+      engine = optimization_engine(options)
       result = nil
       previous_solution = nil
-      until (previous_solution = bab.next).nil?
+      until (previous_solution = engine.next).nil?
         result = previous_solution
       end
-      @gecoder_mixin_statistics = bab.statistics
+      @gecoder_mixin_statistics = engine.statistics
       
       # Reset the method used constrain calls and return the result.
       Mixin.constrain_proc = nil
+      raise Gecode::SearchAbortedError if result.nil? and engine.stopped
       raise Gecode::NoSolutionError if result.nil?
       
       # Switch to the result.
@@ -150,14 +224,16 @@ module Gecode
     #
     #   model.maximize! :profit
     #
-    # Raises Gecode::NoSolutionError if no solution can be found.
-    def maximize!(var)
+    # Raises Gecode::NoSolutionError if no solution can be found. Accepts the 
+    # same options as #optimize! .
+    def maximize!(var, options = {})
       variable = self.method(var).call
       unless variable.kind_of? Gecode::IntVar
         raise ArgumentError.new("Expected integer variable, got #{variable.class}.")
       end
       
-      optimize! do |model, best_so_far|
+      kind = "maximize #{variable.index}"
+      cached_optimize!(variable, kind, options) do |model, best_so_far|
         model.method(var).call.must > best_so_far.method(var).call.value
       end
     end
@@ -169,14 +245,16 @@ module Gecode
     #
     #   model.minimize! :cost
     #
-    # Raises Gecode::NoSolutionError if no solution can be found.
-    def minimize!(var)
+    # Raises Gecode::NoSolutionError if no solution can be found. Accepts the 
+    # same options as #optimize! .
+    def minimize!(var, options = {})
       variable = self.method(var).call
       unless variable.kind_of? Gecode::IntVar
         raise ArgumentError.new("Expected integer variable, got #{variable.class}.")
       end
       
-      optimize! do |model, best_so_far|
+      kind = "minimize #{variable.index}"
+      cached_optimize!(variable, kind, options) do |model, best_so_far|
         model.method(var).call.must < best_so_far.method(var).call.value
       end
     end
@@ -195,6 +273,44 @@ module Gecode
           @constrain_proc.call(home, best)
         end
       end
+
+      # Sets the Gecode::SolutionCache used by all models. Caching is
+      # disabled by setting it to nil (the default).
+      def solution_cache=(cache)
+        @solution_cache = cache
+      end
+
+      # Gets the Gecode::SolutionCache used by all models, nil if solutions
+      # are not cached.
+      def solution_cache
+        @solution_cache
+      end
+    end
+    
+    protected
+
+    # Returns the values of the integer, boolean and set variables in the 
+    # selected space as three arrays indexed by variable identifier. The
+    # values of unassigned variables are nil.
+    def solution_values #:nodoc:
+      space = selected_space
+      int_values = (0...space.int_var_count).map do |i|
+        var = space.int_var(i)
+        var.assigned ? var.val : nil
+      end
+      bool_values = (0...space.bool_var_count).map do |i|
+        var = space.bool_var(i)
+        var.assigned ? var.val : nil
+      end
+      set_values = (0...space.set_var_count).map do |i|
+        var = space.set_var(i)
+        if var.assigned
+          (var.glbMin..var.glbMax).select{ |e| var.contains(e) }
+        else
+          nil
+        end
+      end
+      return int_values, bool_values, set_values
     end
     
     private
@@ -202,9 +318,18 @@ module Gecode
     # Creates a depth first search engine for search, executing any 
     # unexecuted constraints first.
     def dfs_engine(options = {})
+      opt_struct = search_options(options)
+
       # Execute constraints.
       perform_queued_gecode_interactions
-      
+
+      # Construct the engine.
+      Gecode::Raw::DFS.new(selected_space, opt_struct)
+    end
+
+    # Decodes the specified search options into the option struct used by 
+    # the search engines.
+    def search_options(options)
       # Begin constructing the option struct.
       opt_struct = Gecode::Raw::Search::Options.new
       opt_struct.c_d = Gecode::Raw::Search::Config::MINIMAL_DISTANCE
@@ -221,9 +346,173 @@ module Gecode
         raise ArgumentError, 'Unrecognized search option: ' + 
           options.keys.first.to_s
       end
+      return opt_struct
+    end
+    
+    # Performs #optimize! of the specified objective variable unless a 
+    # solution for the same kind of optimization of an identical model can 
+    # be found in the solution cache. The kind should identify the 
+    # objective.
+    def cached_optimize!(objective, kind, options, &block)
+      perform_queued_gecode_interactions
+      key = nil
+      unless options.has_key? :time_limit
+        sorted_options = options.to_a.sort_by{ |name, value| name.to_s }
+        key = solution_cache_key("#{kind} #{sorted_options.inspect}")
+      end
+      return self if restore_cached_solution(key)
 
-      # Construct the engine.
-      Gecode::Raw::DFS.new(selected_space, opt_struct)
+      # The objective must never be fixed by LNS.
+      @gecoder_mixin_objective = objective
+      begin
+        optimize!(options, &block)
+      ensure
+        @gecoder_mixin_objective = nil
+      end
+      cache_solution(key)
+      return self
+    end
+
+    # Returns the key under which solutions of the specified kind of search
+    # from the selected space are cached. Returns nil if no cache is used,
+    # the space is failed or the space can't be fingerprinted.
+    def solution_cache_key(kind)
+      return nil if Mixin.solution_cache.nil?
+      space = selected_space
+      space.status
+      return nil if space.failed
+      fingerprint = space.fingerprint
+      return nil if fingerprint.empty?
+      Gecode::SolutionCache.key(kind, fingerprint)
+    end
+
+    # Looks up the solution stored under the specified key and, if there
+    # is one, assigns it to a copy of the selected space which then becomes
+    # the active space. Returns whether a solution was restored.
+    def restore_cached_solution(key)
+      return false if key.nil?
+      solution = Mixin.solution_cache.fetch(key)
+      return false if solution.nil?
+
+      int_values, bool_values, set_values = solution
+      space = selected_space.clone(true)
+      int_values.each_with_index do |value, i|
+        next if value.nil?
+        Gecode::Raw::rel(space, space.int_var(i), Gecode::Raw::IRT_EQ, 
+          value, Gecode::Raw::ICL_DEF, Gecode::Raw::PK_DEF)
+      end
+      bool_values.each_with_index do |value, i|
+        next if value.nil?
+        Gecode::Raw::rel(space, space.bool_var(i), Gecode::Raw::IRT_EQ, 
+          value, Gecode::Raw::ICL_DEF, Gecode::Raw::PK_DEF)
+      end
+      set_values.each_with_index do |value, i|
+        next if value.nil?
+        Gecode::Raw::dom(space, space.set_var(i), Gecode::Raw::SRT_EQ, 
+          Gecode::Raw::IntSet.new(value, value.size))
+      end
+      space.status
+      if space.failed
+        Mixin.solution_cache.discard(key)
+        return false
+      end
+
+      self.active_space = space
+      @gecoder_mixin_statistics = nil
+      return true
+    end
+
+    # Stores the values of the variables in the active space in the 
+    # solution cache under the specified key.
+    def cache_solution(key)
+      return if key.nil?
+      Mixin.solution_cache.store(key, solution_values)
+    end
+
+    # Used in place of the values of variables that have no value in the
+    # guide.
+    NO_GUIDED_VALUE = MAX_INT + 1 #:nodoc:
+
+    # Executes the block, which should create a search engine, with the 
+    # specified solution values (see #solution_values) as the guide of the 
+    # selected space. The guide is only kept by the spaces of the engine. 
+    # Returns the result of the block.
+    def with_guide(values, &block)
+      return yield if values.nil?
+      int_values, bool_values = values.map do |enum_values|
+        enum_values.map{ |value| value.nil? ? NO_GUIDED_VALUE : value }
+      end
+      space = selected_space
+      space.set_guide(int_values, bool_values)
+      begin
+        yield
+      ensure
+        space.set_guide([], [])
+      end
+    end
+    
+    # Maps the names of the supported LNS neighbourhoods to the 
+    # corresponding constant in Gecode.
+    LNS_NEIGHBOURHOOD_CONSTANTS = { #:nodoc:
+      :random => Gecode::Raw::LNS_RANDOM,
+      :block  => Gecode::Raw::LNS_BLOCK
+    }
+    
+    # Creates the search engine used to find optimal solutions, as 
+    # specified by the options given to #optimize! .
+    def optimization_engine(options)
+      options = options.dup
+      engine = options.delete(:engine) || :bab
+      unless [:bab, :lns].include? engine
+        raise ArgumentError, "Unknown search engine: #{engine}"
+      end
+
+      opt_struct = Gecode::Raw::Search::Options.new
+      opt_struct.c_d = Gecode::Raw::Search::Config::MINIMAL_DISTANCE
+      opt_struct.a_d = Gecode::Raw::Search::Config::ADAPTIVE_DISTANCE
+      opt_struct.stop = nil
+      if engine == :bab
+        unless options.empty?
+          raise ArgumentError, 'Unrecognized search option: ' + 
+            options.keys.first.to_s
+        end
+        return Gecode::Raw::BAB.new(selected_space, opt_struct)
+      end
+
+      # Decode the LNS options.
+      if options.has_key? :time_limit
+        opt_struct.stop = Gecode::Raw::Search::Stop.new(-1, 
+          options.delete(:time_limit), -1)
+      end
+      relaxation = options.delete(:relaxation) || 0.2
+      unless relaxation.kind_of?(Numeric) and relaxation >= 0 and 
+          relaxation <= 1
+        raise ArgumentError, 'The relaxation must be a number between 0 ' + 
+          "and 1, got #{relaxation.inspect}."
+      end
+      neighbourhood = options.delete(:neighbourhood) || :random
+      unless LNS_NEIGHBOURHOOD_CONSTANTS.include? neighbourhood
+        raise ArgumentError, "Unknown neighbourhood: #{neighbourhood}"
+      end
+      fail_limit = options.delete(:fail_limit) || 100
+      iterations = options.delete(:iterations) || 1000
+      seed = options.delete(:seed) || 1
+      
+      unless options.empty?
+        raise ArgumentError, 'Unrecognized search option: ' + 
+          options.keys.first.to_s
+      end
+
+      # Only the decision variables are fixed in the neighbourhoods.
+      int_ids = branched_variable_ids[:int].uniq
+      unless @gecoder_mixin_objective.nil?
+        int_ids.delete @gecoder_mixin_objective.index
+      end
+      bool_ids = branched_variable_ids[:bool].uniq
+
+      Gecode::Raw::LNS.new(selected_space, opt_struct, int_ids, bool_ids,
+        LNS_NEIGHBOURHOOD_CONSTANTS[neighbourhood], (relaxation * 100).round, 
+        fail_limit, iterations, seed)
     end
   end
 end
@@ -0,0 +1,228 @@
+require 'digest/sha1'
+
+module Gecode
+  # Remembers solutions found by Mixin#solve!, Mixin#maximize! and
+  # Mixin#minimize! so that models which are identical (once their
+  # constraints have been posted and propagated) get the solution without
+  # searching again. The cache is enabled for all models by assigning it
+  # to Gecode::Mixin.solution_cache .
+  #
+  #   Gecode::Mixin.solution_cache = Gecode::SolutionCache.new(
+  #     :capacity => 1000, :directory => '/var/cache/my_service')
+  #
+  # Models are identified by a fingerprint of their variables' domains,
+  # their propagators (with arguments) and their branchings. Variables are
+  # numbered in the order that they are created, so two models are only
+  # regarded as identical if they create their variables and post their
+  # constraints in the same order.
+  #
+  # Solutions found using #optimize! with a custom block are not cached,
+  # since the block can not be fingerprinted. Neither are solutions found
+  # using LNS with a time limit, since they depend on timing.
+  #
+  # The following options can be specified in a hash with symbols as keys
+  # when creating the cache:
+  #
+  # [:capacity]  The number of solutions kept in memory. The least
+  #              recently used solution is dropped when the cache is full.
+  #              Defaults to 100.
+  # [:directory] A directory where solutions are also stored on disk, so
+  #              that they can be shared between processes and survive
+  #              restarts. No solutions are stored on disk by default.
+  #
+  # Solutions are stored on disk as plain text (the values of the 
+  # variables), so reading a file never executes code. Files that can not
+  # be parsed are ignored. A restored solution is only checked against the 
+  # model's constraints though, so the directory should only be writable by
+  # trusted processes. Solutions stored on disk are never evicted, the 
+  # capacity only limits the number of solutions in memory. Old files have
+  # to be removed from the directory by other means (e.g. a cron job).
+  class SolutionCache
+    # The first line of files with solutions stored on disk.
+    FILE_HEADER = 'gecoder solution 1' #:nodoc:
+
+    # The number of lookups that found a solution.
+    attr :hits
+    # The number of lookups that did not find a solution.
+    attr :misses
+    # The number of solutions kept in memory.
+    attr :capacity
+    # The directory where solutions are stored on disk (nil if none).
+    attr :directory
+
+    # Creates a new empty cache. See SolutionCache for the options.
+    def initialize(options = {})
+      options = options.dup
+      @capacity = options.delete(:capacity) || 100
+      @directory = options.delete(:directory)
+      unless options.empty?
+        raise ArgumentError, 'Unrecognized cache option: ' +
+          options.keys.first.to_s
+      end
+      unless @capacity.kind_of?(Fixnum) and @capacity > 0
+        raise ArgumentError, 'The capacity must be a positive integer, ' +
+          "got #{@capacity.inspect}."
+      end
+      unless @directory.nil? or File.directory?(@directory)
+        Dir.mkdir(@directory)
+      end
+
+      @hits = 0
+      @misses = 0
+      @solutions = {}
+      # The keys of the solutions in memory, least recently used first.
+      @keys = []
+    end
+
+    # Returns the number of solutions in memory.
+    def size
+      @solutions.size
+    end
+
+    # Returns a hash with the keys :hits, :misses and :size, suitable for
+    # monitoring.
+    def stats
+      {:hits => @hits, :misses => @misses, :size => size}
+    end
+
+    # Removes all solutions from memory and resets the counters. Solutions
+    # stored on disk are kept.
+    def clear
+      @solutions.clear
+      @keys.clear
+      @hits = 0
+      @misses = 0
+      return self
+    end
+
+    # Computes the key used to store solutions for a search of the
+    # specified kind from a space with the specified fingerprint.
+    def self.key(kind, fingerprint) #:nodoc:
+      Digest::SHA1.hexdigest("#{kind}\n#{fingerprint}")
+    end
+
+    # Returns the solution stored under the specified key, or nil if there
+    # is none.
+    def fetch(key) #:nodoc:
+      solution = @solutions[key]
+      if solution.nil?
+        solution = read_from_disk(key)
+        remember(key, solution) unless solution.nil?
+      else
+        @keys.delete(key)
+        @keys << key
+      end
+
+      if solution.nil?
+        @misses += 1
+      else
+        @hits += 1
+      end
+      return solution
+    end
+
+    # Stores the solution under the specified key.
+    def store(key, solution) #:nodoc:
+      remember(key, solution)
+      write_to_disk(key, solution)
+    end
+
+    # Drops the solution stored under the specified key, which was found 
+    # but could not be used, and counts the lookup that found it as a miss.
+    def discard(key) #:nodoc:
+      @hits -= 1
+      @misses += 1
+      @keys.delete(key)
+      @solutions.delete(key)
+      File.delete(path(key)) if @directory and File.exist?(path(key))
+    end
+
+    private
+
+    # Puts the solution in memory, dropping the least recently used one if
+    # the cache is full.
+    def remember(key, solution)
+      @keys.delete(key)
+      @keys << key
+      @solutions[key] = solution
+      @solutions.delete(@keys.shift) while @keys.size > @capacity
+    end
+
+    # Returns the path of the file where the solution with the specified
+    # key is stored.
+    def path(key)
+      File.join(@directory, key + '.solution')
+    end
+
+    # Reads the solution with the specified key from disk. Returns nil if
+    # there is no directory, no such solution, or the file can't be read.
+    def read_from_disk(key)
+      return nil if @directory.nil? or not File.exist?(path(key))
+      begin
+        decode(File.open(path(key), 'rb'){ |file| file.read })
+      rescue StandardError
+        nil
+      end
+    end
+
+    # Writes the solution to disk, if a directory has been given. The file
+    # is renamed into place so that readers never see a partial solution.
+    def write_to_disk(key, solution)
+      return if @directory.nil?
+      tmp_path = "#{path(key)}.#{Process.pid}.tmp"
+      File.open(tmp_path, 'wb'){ |file| file.write encode(solution) }
+      File.rename(tmp_path, path(key))
+    end
+
+    # Encodes the solution as text: the header followed by one line each 
+    # for the values of the integer, boolean and set variables. Unassigned
+    # variables are written as "-" and sets as their elements in braces, 
+    # e.g. "{1,3}".
+    def encode(solution)
+      int_values, bool_values, set_values = solution
+      lines = [FILE_HEADER]
+      [int_values, bool_values].each do |values|
+        lines << values.map{ |value| value.nil? ? '-' : value.to_s }.join(' ')
+      end
+      lines << set_values.map do |value|
+        value.nil? ? '-' : "{#{value.join(',')}}"
+      end.join(' ')
+      return lines.join("\n") + "\n"
+    end
+
+    # Decodes a solution encoded by #encode. Raises ArgumentError if the 
+    # text is not a solution.
+    def decode(text)
+      lines = text.split("\n", -1)
+      unless lines.size == 5 and lines.first == FILE_HEADER and 
+          lines.last.empty?
+        raise ArgumentError, 'Not a solution.'
+      end
+
+      int_values, bool_values = lines[1, 2].map do |line|
+        line.split(' ').map do |token|
+          token == '-' ? nil : decode_integer(token)
+        end
+      end
+      set_values = lines[3].split(' ').map do |token|
+        if token == '-'
+          nil
+        elsif token =~ /\A\{(.*)\}\z/
+          $1.split(',').map{ |element| decode_integer(element) }
+        else
+          raise ArgumentError, "Malformed set: #{token}"
+        end
+      end
+      return int_values, bool_values, set_values
+    end
+
+    # Decodes a decimal integer. Raises ArgumentError if the token is 
+    # something else.
+    def decode_integer(token)
+      unless token =~ /\A-?\d+\z/
+        raise ArgumentError, "Malformed integer: #{token}"
+      end
+      token.to_i
+    end
+  end
+end
@@ -3,6 +3,8 @@ module Gecode
   # space.  
   class FreeVarBase #:nodoc:
     attr_accessor :model
+    # The identifier of the variable in the model's spaces.
+    attr :index
   
     # Creates an int variable with the specified index.
     def initialize(model, index)
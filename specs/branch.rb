@@ -22,12 +22,20 @@ describe Gecode::Mixin, ' (integer branch)' do
   end
 
   it 'should default to :none and :min' do
-    Gecode::Raw.should_receive(:branch).once.with(
-      an_instance_of(Gecode::Raw::Space), 
-      anything, Gecode::Raw::INT_VAR_NONE, Gecode::Raw::INT_VAL_MIN)
+    Gecode::Raw.should_receive(:guided_branch).once.with(
+      an_instance_of(Gecode::Raw::Space), anything, [0, 1],
+      Gecode::Raw::INT_VAR_NONE, Gecode::Raw::INT_VAL_MIN)
     @model.branch_on @vars
     @model.solve!
   end
+
+  it 'should post a guided branching over the bool variables' do
+    Gecode::Raw.should_receive(:guided_branch).once.with(
+      an_instance_of(Gecode::Raw::Space), anything, [0, 1],
+      Gecode::Raw::INT_VAR_NONE, Gecode::Raw::INT_VAL_MIN)
+    @model.branch_on @bools
+    @model.solve!
+  end
   
   it 'should ensure that branched int variables are assigned in a solution' do
     @model.branch_on @vars
@@ -65,9 +73,9 @@ describe Gecode::Mixin, ' (integer branch)' do
     :largest_max_regret   => Gecode::Raw::INT_VAR_REGRET_MAX_MAX
   }.each_pair do |name, gecode_const|
     it "should support #{name} as variable selection strategy" do
-      Gecode::Raw.should_receive(:branch).once.with(
-        an_instance_of(Gecode::Raw::Space),
-        anything, gecode_const, an_instance_of(Numeric))
+      Gecode::Raw.should_receive(:guided_branch).once.with(
+        an_instance_of(Gecode::Raw::Space), anything, [0, 1], 
+        gecode_const, an_instance_of(Numeric))
       @model.branch_on @vars, :variable => name
       @model.solve!
     end
@@ -81,9 +89,9 @@ describe Gecode::Mixin, ' (integer branch)' do
     :split_max  => Gecode::Raw::INT_VAL_SPLIT_MAX
   }.each_pair do |name, gecode_const|
     it "should support #{name} as value selection strategy" do
-      Gecode::Raw.should_receive(:branch).once.with(
-        an_instance_of(Gecode::Raw::Space), 
-        anything, an_instance_of(Numeric), gecode_const)
+      Gecode::Raw.should_receive(:guided_branch).once.with(
+        an_instance_of(Gecode::Raw::Space), anything, [0, 1], 
+        an_instance_of(Numeric), gecode_const)
       @model.branch_on @vars, :value => name
       @model.solve!
     end
@@ -114,6 +122,41 @@ describe Gecode::Mixin, ' (integer branch)' do
   end
 end
 
+describe Gecode::Mixin, ' (integer branch without a guide)' do
+  # Returns all solutions of a small model branched on with the specified
+  # options.
+  def all_solutions(options)
+    model = Gecode::Model.new
+    vars = model.int_var_array(4, 0..4)
+    vars.must_be.distinct
+    vars[0].must > vars[3]
+    bools = model.bool_var_array(3)
+    (bools[0] | bools[1]).must_be.true
+    model.branch_on vars, options.dup
+    model.branch_on bools, options.dup
+    
+    solutions = []
+    model.each_solution{ solutions << [vars.values, bools.values] }
+    return solutions
+  end
+
+  [[:none, :min], [:smallest_size, :max], [:largest_degree, :split_min], 
+    [:smallest_max_regret, :med], [:largest_min, :split_max]
+  ].each do |var_strat, val_strat|
+    it "should search like Gecode's branching using #{var_strat} and " + 
+        "#{val_strat}" do
+      options = {:variable => var_strat, :value => val_strat}
+      guided = all_solutions(options)
+      
+      Gecode::Raw.stub!(:guided_branch).and_return do |space, vars, ids, 
+          var_const, val_const|
+        Gecode::Raw.branch(space, vars, var_const, val_const)
+      end
+      guided.should == all_solutions(options)
+    end
+  end
+end
+
 describe Gecode::Mixin, ' (set branch)' do
   before do
     @model = BranchSampleProblem.new
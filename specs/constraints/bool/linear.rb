@@ -213,3 +213,162 @@ describe Gecode::Int::Linear, '(with booleans)' do
     end
   end
 end
+
+describe Gecode::Int::Linear, '(with many booleans)' do
+  before do
+    @model = Gecode::Model.new
+    @size = Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD + 8
+    @bools = @model.bool_var_array(@size)
+    @model.branch_on @bools, :value => :max
+    @weights = (1..@size).map{ |i| (i * 7) % 23 - 5 }
+    @expression = (0...@size).inject(0){ |sum, i| @bools[i] * @weights[i] + sum }
+  end
+
+  # Computes the value of the expression in the current solution.
+  def expression_value
+    values = @bools.values.map{ |bool| bool.to_i }
+    values.zip(@weights).inject(0){ |sum, (value, weight)| sum + value*weight }
+  end
+
+  it 'should post the pseudo-Boolean propagator' do
+    Gecode::Raw.should_receive(:pseudo_boolean_linear)
+    @expression.must <= 17
+    @model.solve!
+  end
+
+  it 'should not post the pseudo-Boolean propagator when reified' do
+    Gecode::Raw.should_not_receive(:pseudo_boolean_linear)
+    @expression.must.equal(17, :reify => @model.bool_var)
+    @model.solve!
+  end
+
+  it 'should not post the pseudo-Boolean propagator for few terms' do
+    Gecode::Raw.should_not_receive(:pseudo_boolean_linear)
+    (@bools[0] * 3 + @bools[1] * 2).must <= 1
+    @model.solve!
+  end
+
+  it 'should handle variables on both sides' do
+    @expression.must == @bools[0] + @bools[1]
+    @model.solve!
+    expression_value.should == @bools[0].value.to_i + @bools[1].value.to_i
+  end
+
+  it 'should handle constants on both sides' do
+    (@expression + 3).must == 20
+    @model.solve!.should_not be_nil
+    expression_value.should == 17
+  end
+
+  it 'should handle variables that occur more than once' do
+    (@expression - @bools[0] * 40).must >= 0
+    @bools[0].must_be.true
+    @model.solve!
+    (expression_value - 40).should >= 0
+  end
+
+  it 'should handle variables that occur more than once with mixed signs' do
+    others = (1...@size).inject(0){ |sum, i| @bools[i] + sum }
+    (@bools[0] * 600 - @bools[0] * 10 + others).must <= 5
+    @model.solve!
+    @bools[0].value.should == false
+    @bools.values.select{ |value| value }.size.should == 5
+  end
+
+  it 'should fail when the relation can not hold' do
+    positive_sum = @weights.select{ |weight| weight > 0 }.inject(0){ |a, b| a + b }
+    @expression.must > positive_sum
+    lambda{ @model.solve! }.should raise_error(Gecode::NoSolutionError)
+  end
+
+  relations = ['>', '>=', '<', '<=', '==']
+
+  relations.each do |relation|
+    it "should handle #{relation}" do
+      @expression.must.send(relation, 17)
+      @model.solve!
+      expression_value.should.send(relation, 17)
+    end
+  end
+
+  relations.each do |relation|
+    it "should handle negated #{relation}" do
+      @expression.must_not.send(relation, 17)
+      @model.solve!
+      expression_value.should_not.send(relation, 17)
+    end
+  end
+end
+
+describe Gecode::Int::Linear, '(with many booleans compared to MiniModel)' do
+  after do
+    Gecode::Bool::Linear.pseudo_boolean_threshold = 
+      Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD
+  end
+
+  # Returns all solutions of a random model with a linear relation over 
+  # many booleans, all but a few of which are fixed either before or after
+  # the relation is posted. Some variables also get a second term if 
+  # repeated is true. The same seed gives the same model.
+  def random_instance_solutions(seed, repeated = false)
+    srand(seed)
+    size = Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD + 4
+    weights = Array.new(size){ rand(41) - 20 }
+    fixed = (0...size).sort_by{ rand }[0, size - 6]
+    fixed_values = fixed.map{ rand(2) == 0 }
+    fixed_before = fixed.select{ rand(2) == 0 }
+    relation = ['==', '<=', '<', '>=', '>'][rand(5)]
+    negated = rand(2) == 0
+    fixed_sum = 0
+    fixed.each_with_index do |i, j|
+      fixed_sum += weights[i] if fixed_values[j]
+    end
+    rhs = fixed_sum + rand(41) - 20
+
+    model = Gecode::Model.new
+    bools = model.bool_var_array(size)
+    fix = lambda do |before|
+      fixed.each_with_index do |i, j|
+        next unless fixed_before.include?(i) == before
+        if fixed_values[j]
+          bools[i].must_be.true
+        else
+          bools[i].must_be.false
+        end
+      end
+    end
+    fix.call(true)
+    expression = (0...size).inject(0){ |sum, i| bools[i] * weights[i] + sum }
+    if repeated
+      4.times{ expression = bools[rand(size)] * (rand(601) - 300) + expression }
+    end
+    (negated ? expression.must_not : expression.must).send(relation, rhs)
+    fix.call(false)
+    model.branch_on bools
+    
+    solutions = []
+    model.each_solution{ solutions << bools.values }
+    return solutions
+  end
+
+  20.times do |seed|
+    it "should find the same solutions as MiniModel (instance #{seed})" do
+      Gecode::Bool::Linear.pseudo_boolean_threshold = nil
+      expected = random_instance_solutions(seed)
+      Gecode::Bool::Linear.pseudo_boolean_threshold = 
+        Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD
+      random_instance_solutions(seed).should == expected
+    end
+  end
+
+  20.times do |seed|
+    it "should find the same solutions as MiniModel (instance #{seed} " + 
+        'with repeated variables)' do
+      Gecode::Bool::Linear.pseudo_boolean_threshold = nil
+      expected = random_instance_solutions(seed, true)
+      Gecode::Bool::Linear.pseudo_boolean_threshold = 
+        Gecode::Bool::Linear::PSEUDO_BOOLEAN_THRESHOLD
+      random_instance_solutions(seed, true).should == expected
+    end
+  end
+end
@@ -68,6 +68,29 @@ class SampleOptimizationProblem2
   end
 end
 
+class QueensSampleProblem
+  include Gecode::Mixin
+
+  attr :queens
+  attr :bools
+
+  def initialize(n = 10)
+    @queens = int_var_array(n, 0...n)
+    @queens.must_be.distinct
+    n.times do |i|
+      (i+1).upto(n-1) do |j|
+        (@queens[i] - @queens[j]).must_not == j - i
+        (@queens[i] - @queens[j]).must_not == i - j
+      end
+    end
+    @bools = bool_var_array(3)
+    (@bools[0] | @bools[1]).must_be.true
+
+    branch_on @queens, :variable => :none, :value => :min
+    branch_on @bools
+  end
+end
+
 class Array
   # Computes a number of the specified base using the array's elements as 
   # digits.
@@ -331,6 +354,169 @@ describe Gecode::Mixin, '(optimization search)' do
   end
 end
 
+describe Gecode::Mixin, '(optimization search using LNS)' do
+  it 'should optimize the solution when the whole model is relaxed' do
+    solution = SampleOptimizationProblem2.new.optimize!(:engine => :lns, 
+        :relaxation => 1.0, :fail_limit => 1000) do |model, best_so_far|
+      model.money.to_number.must > best_so_far.money.values.to_number
+    end
+    solution.should_not be_nil
+    solution.money.values.to_number.should == 498
+  end
+
+  it 'should find a solution using the block neighbourhood' do
+    solution = SampleOptimizationProblem2.new.optimize!(:engine => :lns, 
+        :neighbourhood => :block, :relaxation => 0.5, 
+        :seed => 17) do |model, best_so_far|
+      model.money.to_number.must > best_so_far.money.values.to_number
+    end
+    solution.should_not be_nil
+    solution.money.values.to_number.should == 498
+  end
+
+  it 'should give the same result for the same seed' do
+    results = (1..2).map do 
+      model = SampleOptimizationProblem2.new
+      model.optimize!(:engine => :lns, :iterations => 5, 
+          :seed => 17) do |model, best_so_far|
+        model.money.to_number.must > best_so_far.money.values.to_number
+      end
+      model.money.values
+    end
+    results.first.should == results.last
+  end
+  
+  it 'should be usable through #maximize!' do
+    solution = SampleOptimizationProblem.new.maximize!(:z, :engine => :lns,
+      :relaxation => 1.0)
+    solution.z.value.should == 25
+  end
+
+  it 'should improve on the first solution with the default relaxation' do
+    SampleOptimizationProblem.new.solve!.z.value.should == 0
+    solution = SampleOptimizationProblem.new.maximize!(:z, :engine => :lns)
+    solution.z.value.should == 25
+  end
+
+  it 'should never fix the objective' do
+    model = SampleOptimizationProblem.new
+    model.x.must > 0
+    model.y.must > 0
+    model.maximize!(:z, :engine => :lns, :relaxation => 0.5, :seed => 17)
+    model.z.value.should == 25
+  end
+
+  it 'should update the search statistics' do
+    model = SampleOptimizationProblem.new
+    model.maximize!(:z, :engine => :lns)
+    model.z.value.should == 25
+    
+    stats = model.search_stats
+    stats.should_not be_nil
+    stats[:propagations].should > 0
+    stats[:memory].should > 0
+  end
+
+  it 'should raise NoSolutionError if there is no solution' do
+    model = SampleOptimizationProblem.new
+    model.z.must > 25
+    lambda do 
+      model.maximize!(:z, :engine => :lns)
+    end.should raise_error(Gecode::NoSolutionError)
+  end
+
+  it 'should raise error if an unknown engine is given' do
+    lambda do 
+      SampleOptimizationProblem.new.maximize!(:z, :engine => :foo)
+    end.should raise_error(ArgumentError)
+  end
+  
+  it 'should raise error if an unknown neighbourhood is given' do
+    lambda do 
+      SampleOptimizationProblem.new.maximize!(:z, :engine => :lns,
+        :neighbourhood => :foo)
+    end.should raise_error(ArgumentError)
+  end
+
+  it 'should raise error if the relaxation is out of range' do
+    lambda do 
+      SampleOptimizationProblem.new.maximize!(:z, :engine => :lns,
+        :relaxation => 1.5)
+    end.should raise_error(ArgumentError)
+  end
+  
+  it 'should raise error if an unrecognised option is passed' do
+    lambda do 
+      SampleOptimizationProblem.new.maximize!(:z, :engine => :lns, 
+        :foo => 1)
+    end.should raise_error(ArgumentError)
+  end
+
+  it 'should raise error if LNS options are passed to BAB' do
+    lambda do 
+      SampleOptimizationProblem.new.maximize!(:z, :relaxation => 0.5)
+    end.should raise_error(ArgumentError)
+  end
+end
+
+describe Gecode::Mixin, '(warm started search)' do
+  before do
+    @model = QueensSampleProblem.new.solve!
+    @previous_queens = @model.queens.values
+    @previous_bools = @model.bools.values
+  end
+
+  it 'should find the previous solution without failing' do
+    @model.solve!(:warm_start => @model)
+    @model.queens.values.should == @previous_queens
+    @model.search_stats[:failures].should == 0
+  end
+
+  it 'should respect constraints added after the previous search' do
+    @model.queens.last.must_not == @previous_queens.last
+    @model.solve!(:warm_start => @model)
+    @model.queens.values.last.should_not == @previous_queens.last
+    @model.queens.values.uniq.size.should == @previous_queens.size
+  end
+
+  it 'should fail much less than a search from scratch' do
+    model = QueensSampleProblem.new(20).solve!
+    previous_first = model.queens.values.first
+    model.queens.first.must_not == previous_first
+    model.solve!(:warm_start => model)
+    
+    cold_model = QueensSampleProblem.new(20)
+    cold_model.queens.first.must_not == previous_first
+    cold_model.solve!
+    (model.search_stats[:failures] * 100).should < 
+      cold_model.search_stats[:failures]
+  end
+
+  it 'should prefer the previous values of boolean variables' do
+    @model.bools[0].must_be.true
+    @model.solve!(:warm_start => @model)
+    @model.bools.values[1..-1].should == @previous_bools[1..-1]
+  end
+
+  it 'should fall back to the selected value when there is no previous value' do
+    QueensSampleProblem.new.solve!(:warm_start => Gecode::Model.new).
+      queens.values.should == @previous_queens
+  end
+
+  it 'should accept the solution of another model' do
+    model = QueensSampleProblem.new
+    model.queens.first.must_not == @previous_queens.first
+    model.solve!(:warm_start => @model)
+    model.queens.values.first.should_not == @previous_queens.first
+  end
+
+  it 'should raise error if the warm start is not a model' do
+    lambda do 
+      @model.solve!(:warm_start => @previous_queens)
+    end.should raise_error(TypeError)
+  end
+end
+
 describe 'single variable optimization', :shared => true do
   it "should support #{@method_name} having the variable given as a symbol" do
     solution = @model.method(@method_name).call(@variable_name.to_sym)
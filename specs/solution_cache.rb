@@ -0,0 +1,188 @@
+require File.dirname(__FILE__) + '/spec_helper'
+require 'tmpdir'
+require 'fileutils'
+
+class CacheSampleProblem
+  include Gecode::Mixin
+
+  attr :vars
+  attr :sets
+
+  def initialize(upper_bound = 9)
+    @vars = int_var_array(3, 0..upper_bound)
+    @vars.must_be.distinct
+    (@vars[0] + @vars[1]).must == @vars[2]
+    @sets = set_var_array(1, [], 0..2, 2)
+    @bools = bool_var_array(2)
+    (@bools[0] | @bools[1]).must_be.true
+
+    branch_on @vars, :variable => :smallest_size, :value => :max
+    branch_on @bools
+    branch_on @sets
+  end
+
+  def last_var
+    @vars[2]
+  end
+end
+
+describe Gecode::SolutionCache do
+  before do
+    @cache = Gecode::SolutionCache.new(:capacity => 2)
+    Gecode::Mixin.solution_cache = @cache
+  end
+
+  after do
+    Gecode::Mixin.solution_cache = nil
+  end
+
+  it 'should count a miss the first time a model is solved' do
+    CacheSampleProblem.new.solve!
+    @cache.misses.should == 1
+    @cache.hits.should == 0
+    @cache.size.should == 1
+  end
+
+  it 'should count a hit when an identical model is solved' do
+    CacheSampleProblem.new.solve!
+    CacheSampleProblem.new.solve!
+    @cache.stats.should == {:hits => 1, :misses => 1, :size => 1}
+  end
+
+  it 'should restore the same solution without searching' do
+    expected = CacheSampleProblem.new.solve!
+    model = CacheSampleProblem.new.solve!
+    model.vars.values.should == expected.vars.values
+    model.sets.first.value.to_a.should == expected.sets.first.value.to_a
+    model.search_stats.should be_nil
+  end
+
+  it 'should not create a search engine when the solution is cached' do
+    CacheSampleProblem.new.solve!
+    Gecode::Raw::DFS.should_not_receive(:new)
+    CacheSampleProblem.new.solve!
+  end
+
+  it 'should count a miss if the cached solution can not be restored' do
+    CacheSampleProblem.new.solve!
+    # Corrupt the stored solution.
+    @cache.instance_variable_get(:@solutions).values.first[0][2] = 10
+
+    model = CacheSampleProblem.new.solve!
+    @cache.stats.should == {:hits => 0, :misses => 2, :size => 1}
+    model.search_stats.should_not be_nil
+    model.last_var.value.should == 9
+  end
+
+  it 'should not be used when warm starting' do
+    CacheSampleProblem.new.solve!
+    guide = CacheSampleProblem.new
+    guide.last_var.must < 9
+    guide.solve!
+
+    model = CacheSampleProblem.new.solve!(:warm_start => guide)
+    model.vars.values.should == guide.vars.values
+    model.search_stats.should_not be_nil
+    @cache.stats.should == {:hits => 0, :misses => 2, :size => 2}
+  end
+
+  it 'should not use the solution of a different model' do
+    CacheSampleProblem.new.solve!
+    CacheSampleProblem.new(8).solve!
+    @cache.misses.should == 2
+  end
+
+  it 'should drop the least recently used solution when full' do
+    CacheSampleProblem.new(9).solve!
+    CacheSampleProblem.new(8).solve!
+    CacheSampleProblem.new(9).solve!
+    CacheSampleProblem.new(7).solve!
+    @cache.size.should == 2
+    CacheSampleProblem.new(9).solve!
+    @cache.hits.should == 2
+    CacheSampleProblem.new(8).solve!
+    @cache.misses.should == 4
+  end
+
+  it 'should cache solutions found by #maximize!' do
+    first = CacheSampleProblem.new
+    first.maximize! :last_var
+    second = CacheSampleProblem.new
+    second.maximize! :last_var
+    second.vars.values.should == first.vars.values
+    @cache.hits.should == 1
+  end
+
+  it 'should not cache solutions found by #optimize!' do
+    2.times do
+      CacheSampleProblem.new.optimize! do |model, best_so_far|
+        model.vars[2].must > best_so_far.vars[2].value
+      end
+    end
+    @cache.size.should == 0
+    @cache.hits.should == 0
+  end
+
+  it 'should not be used once disabled' do
+    Gecode::Mixin.solution_cache = nil
+    CacheSampleProblem.new.solve!
+    @cache.misses.should == 0
+  end
+
+  it 'should reset the counters when cleared' do
+    CacheSampleProblem.new.solve!
+    @cache.clear
+    @cache.stats.should == {:hits => 0, :misses => 0, :size => 0}
+  end
+
+  it 'should raise error if the capacity is not positive' do
+    lambda do
+      Gecode::SolutionCache.new(:capacity => 0)
+    end.should raise_error(ArgumentError)
+  end
+
+  it 'should raise error if an unrecognised option is passed' do
+    lambda do
+      Gecode::SolutionCache.new(:foo => 1)
+    end.should raise_error(ArgumentError)
+  end
+end
+
+describe Gecode::SolutionCache, ' (with a directory)' do
+  before do
+    @directory = File.join(Dir.tmpdir, "gecoder_cache_#{Process.pid}")
+    Gecode::Mixin.solution_cache =
+      Gecode::SolutionCache.new(:directory => @directory)
+  end
+
+  after do
+    Gecode::Mixin.solution_cache = nil
+    FileUtils.rm_rf(@directory)
+  end
+
+  it 'should find solutions stored by another cache' do
+    expected = CacheSampleProblem.new.solve!
+
+    cache = Gecode::SolutionCache.new(:directory => @directory)
+    Gecode::Mixin.solution_cache = cache
+    model = CacheSampleProblem.new.solve!
+    cache.hits.should == 1
+    model.vars.values.should == expected.vars.values
+    model.sets.values.map{ |set| set.to_a }.should ==
+      expected.sets.values.map{ |set| set.to_a }
+  end
+
+  it 'should ignore files that are not solutions' do
+    expected = CacheSampleProblem.new.solve!
+    Dir[File.join(@directory, '*')].each do |file_name|
+      File.open(file_name, 'wb'){ |file| Marshal.dump([[1, 2, 3]], file) }
+    end
+
+    cache = Gecode::SolutionCache.new(:directory => @directory)
+    Gecode::Mixin.solution_cache = cache
+    model = CacheSampleProblem.new.solve!
+    cache.hits.should == 0
+    cache.misses.should == 1
+    model.vars.values.should == expected.vars.values
+  end
+end